@@ -0,0 +1,74 @@
+#ifndef DETECTION_ENGINE_H
+#define DETECTION_ENGINE_H
+
+#include "ScratchDetector.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Interface of the stage that turns an edge image into scratches
+ *
+ * ScratchDetector owns preprocessing and edge detection and delegates the
+ * shape analysis to one engine, selected by Parameters::engine.
+ */
+class DetectionEngine {
+public:
+    virtual ~DetectionEngine() = default;
+
+    /**
+     * @brief Short name used in logs and benchmarks
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Find scratches in an edge image
+     * @param edges Binary edge image (CV_8UC1)
+     * @param params Detection parameters
+     * @return Vector of detected scratches
+     */
+    virtual std::vector<Scratch> detect(const cv::Mat& edges,
+                                        const ScratchDetector::Parameters& params) = 0;
+
+    /**
+     * @brief Create the engine for the given type
+     */
+    static std::unique_ptr<DetectionEngine> create(ScratchDetector::Parameters::Engine engine);
+};
+
+/**
+ * @brief Original engine: external contours filtered by geometry
+ */
+class ContourEngine : public DetectionEngine {
+public:
+    const char* name() const override { return "contour"; }
+
+    std::vector<Scratch> detect(const cv::Mat& edges,
+                                const ScratchDetector::Parameters& params) override;
+
+private:
+    /**
+     * @brief Analyze contour to determine if it's a scratch
+     */
+    bool isScratch(const std::vector<cv::Point>& contour,
+                   const ScratchDetector::Parameters& params, Scratch& scratch);
+};
+
+/**
+ * @brief Line engine: probabilistic Hough segments merged into scratches
+ *
+ * Collinear segments that lie within maxWidth of each other (e.g. the two
+ * edges of one scratch, or pieces of a broken scratch) are merged, and the
+ * length is measured along the scratch instead of from the bounding box.
+ * Scratch::contour holds the end points of the merged segments rather than
+ * a traced outline.
+ */
+class LineSegmentEngine : public DetectionEngine {
+public:
+    const char* name() const override { return "lines"; }
+
+    std::vector<Scratch> detect(const cv::Mat& edges,
+                                const ScratchDetector::Parameters& params) override;
+};
+
+#endif // DETECTION_ENGINE_H
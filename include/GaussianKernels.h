@@ -0,0 +1,136 @@
+#ifndef GAUSSIAN_KERNELS_H
+#define GAUSSIAN_KERNELS_H
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Integer taps of the Gaussian kernels used for sigma = 0
+ *
+ * For sizes up to 7, cv::getGaussianKernel uses fixed kernels whose
+ * weights are exact fractions of 2^bits, so an integer blur with these
+ * taps gives the same result as the 8-bit cv::GaussianBlur.
+ */
+template<int KSize> struct GaussianTaps;
+
+template<> struct GaussianTaps<3> {
+    static constexpr int bits = 2;
+    static constexpr int values[3] = {1, 2, 1};
+};
+
+template<> struct GaussianTaps<5> {
+    static constexpr int bits = 4;
+    static constexpr int values[5] = {1, 4, 6, 4, 1};
+};
+
+template<> struct GaussianTaps<7> {
+    static constexpr int bits = 6;
+    static constexpr int values[7] = {2, 7, 14, 18, 14, 7, 2};
+};
+
+/**
+ * @brief Blur output rows [y0, y1) of a CV_8UC1 image (one parallel stripe)
+ *
+ * Horizontal results are kept as 16-bit integers in a ring of KSize rows,
+ * so every source row of the stripe is filtered once. The tap loops have
+ * compile-time bounds and symmetric weights, which lets the compiler
+ * unroll and vectorize them. Borders follow cv::BORDER_REFLECT_101. The
+ * row buffers are per thread and kept between calls.
+ */
+template<int KSize>
+void gaussianBlur8uRows(const cv::Mat& src, cv::Mat& dst, int y0, int y1) {
+    using Taps = GaussianTaps<KSize>;
+    constexpr int radius = KSize / 2;
+    constexpr int shift = 2 * Taps::bits;
+    constexpr uint32_t rounding = 1u << (shift - 1);
+
+    const int rows = src.rows;
+    const int cols = src.cols;
+
+    auto reflect = [](int i, int n) {
+        if (i < 0) return -i;
+        if (i >= n) return 2 * n - 2 - i;
+        return i;
+    };
+
+    thread_local std::vector<uint8_t> padded;
+    thread_local std::vector<uint16_t> ring;
+    padded.resize(cols + 2 * radius);
+    ring.resize(static_cast<size_t>(KSize) * cols);
+    int ringRow[KSize];
+    for (int i = 0; i < KSize; ++i) ringRow[i] = -1;
+
+    auto horizontal = [&](int r) -> const uint16_t* {
+        uint16_t* h = ring.data() + static_cast<size_t>(r % KSize) * cols;
+        if (ringRow[r % KSize] == r) {
+            return h;
+        }
+        const uint8_t* s = src.ptr<uint8_t>(r);
+        std::copy(s, s + cols, padded.begin() + radius);
+        for (int i = 1; i <= radius; ++i) {
+            padded[radius - i] = s[i];
+            padded[radius + cols - 1 + i] = s[cols - 1 - i];
+        }
+        const uint8_t* p = padded.data();
+        for (int x = 0; x < cols; ++x) {
+            // At most 255 * 2^bits, so 16-bit lanes are enough
+            uint16_t sum = static_cast<uint16_t>(Taps::values[radius] * p[x + radius]);
+            for (int i = 0; i < radius; ++i) {
+                sum += static_cast<uint16_t>(Taps::values[i] * (p[x + i] + p[x + KSize - 1 - i]));
+            }
+            h[x] = sum;
+        }
+        ringRow[r % KSize] = r;
+        return h;
+    };
+
+    const uint16_t* h[KSize];
+    for (int y = y0; y < y1; ++y) {
+        for (int i = 0; i < KSize; ++i) {
+            h[i] = horizontal(reflect(y - radius + i, rows));
+        }
+        uint8_t* d = dst.ptr<uint8_t>(y);
+        for (int x = 0; x < cols; ++x) {
+            uint32_t sum = Taps::values[radius] * h[radius][x];
+            for (int i = 0; i < radius; ++i) {
+                sum += Taps::values[i] * (h[i][x] + h[KSize - 1 - i][x]);
+            }
+            d[x] = static_cast<uint8_t>((sum + rounding) >> shift);
+        }
+    }
+}
+
+/**
+ * @brief Separable fixed-point Gaussian blur of a CV_8UC1 image
+ *
+ * Rows are split across threads with cv::parallel_for_. dst is reused
+ * when it already has the right size and does not share data with src.
+ * @param src Input image (CV_8UC1, at least KSize x KSize)
+ * @param dst Output image
+ */
+template<int KSize>
+void gaussianBlur8u(const cv::Mat& src, cv::Mat& dst) {
+    if (dst.data == src.data) {
+        cv::Mat out;
+        gaussianBlur8u<KSize>(src, out);
+        dst = out;
+        return;
+    }
+    dst.create(src.rows, src.cols, CV_8UC1);
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        gaussianBlur8uRows<KSize>(src, dst, range.start, range.end);
+    });
+}
+
+using GaussianBlurFunction = void (*)(const cv::Mat&, cv::Mat&);
+
+/**
+ * @brief Pick the specialized blur for a kernel size
+ * @param kernelSize Gaussian kernel size
+ * @return Specialized function, or nullptr if the size has none
+ */
+GaussianBlurFunction selectGaussianBlur(int kernelSize);
+
+#endif // GAUSSIAN_KERNELS_H
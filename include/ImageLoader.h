@@ -2,7 +2,10 @@
 #define IMAGE_LOADER_H
 
 #include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 /**
@@ -10,6 +13,28 @@
  */
 class ImageLoader {
 public:
+    /**
+     * @brief Options for scanning a directory for images
+     *
+     * Globs support '*' and '?' and ignore case. Include globs are matched
+     * against the path relative to the scanned directory, using '/'
+     * separators ('*' also matches '/'). Exclude globs are matched against
+     * that path and against the entry's own name, so "rejected" skips every
+     * directory of that name. A subdirectory matching an exclude glob is
+     * not entered.
+     */
+    struct ScanOptions {
+        bool recursive;                    // Descend into subdirectories
+        std::vector<std::string> include;  // File globs to accept (empty: all)
+        std::vector<std::string> exclude;  // File/directory globs to skip
+        int threads;                       // Enumeration threads (0: one per core)
+
+        ScanOptions()
+            : recursive(false),
+              include({"*.jpg", "*.jpeg", "*.png", "*.bmp", "*.tif", "*.tiff"}),
+              threads(0) {}
+    };
+    
     /**
      * @brief Load a single image from file
      * @param filepath Path to the image file
@@ -24,6 +49,26 @@ public:
      */
     std::vector<cv::Mat> loadImagesFromDirectory(const std::string& directory);
     
+    /**
+     * @brief List the image files of a directory tree
+     *
+     * Subdirectories are enumerated in parallel. Unreadable directories are
+     * skipped and reported through getLastError().
+     * @param directory Root directory
+     * @param options Recursion, glob filters and thread count
+     * @return Sorted list of file paths (the manifest)
+     */
+    std::vector<std::string> scanDirectory(const std::string& directory,
+                                           const ScanOptions& options = ScanOptions());
+    
+    /**
+     * @brief Ask the OS to start reading a file into the page cache
+     *
+     * Uses posix_fadvise(POSIX_FADV_WILLNEED) where available, otherwise
+     * does nothing.
+     */
+    static void prefetch(const std::string& filepath);
+    
     /**
      * @brief Check if image is valid for processing
      * @param image Image to validate
@@ -40,4 +85,42 @@ private:
     std::string lastError;
 };
 
+/**
+ * @brief Issues read-ahead for the files after the one being decoded
+ *
+ * A small pool of threads claims files from the window of 'depth' files
+ * after the one being processed, so several opens are in flight at once
+ * and the first-byte latency of network disks overlaps instead of adding
+ * up. Decoding and processing the current file overlaps with all of it.
+ */
+class Prefetcher {
+public:
+    /**
+     * @brief Start prefetching from the beginning of the manifest
+     * @param files Manifest; must outlive the Prefetcher
+     * @param depth Number of files to keep prefetched ahead
+     * @param threads Number of files being opened concurrently
+     */
+    Prefetcher(const std::vector<std::string>& files, size_t depth = 16,
+               int threads = 8);
+    ~Prefetcher();
+
+    /**
+     * @brief Tell the prefetcher which file is being processed now
+     */
+    void advance(size_t index);
+
+private:
+    const std::vector<std::string>& files;
+    size_t depth;
+    size_t current;
+    size_t next;             // Next file to claim for prefetching
+    bool stop;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::thread> workers;
+
+    void run();
+};
+
 #endif // IMAGE_LOADER_H
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef REPORT_WRITER_H
+#define REPORT_WRITER_H
+
+#include "ScratchDetector.h"
+#include <opencv2/opencv.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One row of a machine-readable (JSONL) report
+ *
+ * Every line of the report is a flat JSON object with a "type" field:
+ *  - "scratch": one detected scratch of an image
+ *  - "image":   per-image summary, written after its scratch rows; images
+ *               that could not be processed get one with an "error" field
+ *  - "batch":   batch summary, written once when the report is closed
+ */
+struct ReportRecord {
+    enum class Type { Scratch, Image, Batch, Unknown };
+
+    Type type;
+    std::string imageId;
+
+    // "scratch" rows
+    int scratchId;
+    Scratch scratch;                  // contour is not stored
+
+    // "image" rows
+    int scratchCount;
+    bool passed;
+    double maxLength;
+    double cannyThreshold1;
+    double cannyThreshold2;
+    std::string error;                // Empty unless the image could not be processed
+
+    // "batch" rows
+    int imageCount;
+    int totalScratches;
+    int failedImages;
+    int errorImages;
+
+    ReportRecord()
+        : type(Type::Unknown), scratchId(0), scratchCount(0), passed(true),
+          maxLength(0), cannyThreshold1(0), cannyThreshold2(0),
+          imageCount(0), totalScratches(0), failedImages(0), errorImages(0) {}
+};
+
+/**
+ * @brief Writes detection results of a whole batch to one JSONL file
+ *
+ * Rows are appended image by image through a large stream buffer, so a
+ * batch of any size produces a single file and is never held in memory.
+ */
+class ReportWriter {
+public:
+    /**
+     * @brief Constructor
+     * @param bufferSize Size of the output stream buffer in bytes
+     */
+    explicit ReportWriter(size_t bufferSize = 1 << 20);
+    ~ReportWriter();
+
+    /**
+     * @brief Start a new report file (an existing file is replaced)
+     * @param filepath Output file path
+     * @return true if the file could be opened
+     */
+    bool open(const std::string& filepath);
+
+    /**
+     * @brief Append the scratch rows and the summary row of one image
+     * @param imageId Identifier of the image (e.g. its file path)
+     * @param scratches Detected scratches
+     * @param cannyThreshold1 Lower Canny threshold used for the image
+     * @param cannyThreshold2 Upper Canny threshold used for the image
+     * @return false if the report is not open or the write failed
+     */
+    bool writeImage(const std::string& imageId,
+                    const std::vector<Scratch>& scratches,
+                    double cannyThreshold1, double cannyThreshold2);
+
+    /**
+     * @brief Append the summary row of an image that could not be processed
+     * @param imageId Identifier of the image
+     * @param error Reason, stored in the row's "error" field
+     * @return false if the report is not open or the write failed
+     */
+    bool writeImageError(const std::string& imageId, const std::string& error);
+
+    /**
+     * @brief Append the batch summary row and close the file
+     * @return false if any write to the file failed
+     */
+    bool close();
+
+    bool isOpen() const { return out.is_open(); }
+
+    /**
+     * @brief Get the last error message
+     */
+    std::string getLastError() const { return lastError; }
+
+private:
+    std::vector<char> buffer;
+    std::ofstream out;
+    std::string filepath;
+    std::string lastError;
+
+    int imageCount;
+    int totalScratches;
+    int failedImages;
+    int errorImages;
+
+    /**
+     * @brief Write one line, setting lastError if the stream has failed
+     */
+    bool writeLine(const std::string& line);
+};
+
+/**
+ * @brief Reads back a report written by ReportWriter, one row at a time
+ */
+class ReportReader {
+public:
+    /**
+     * @brief Open a report file
+     * @param filepath Path to the JSONL report
+     * @return true if the file could be opened
+     */
+    bool open(const std::string& filepath);
+
+    /**
+     * @brief Read the next row
+     * @param record Filled with the row contents
+     * @return false at end of file; malformed lines are skipped
+     */
+    bool next(ReportRecord& record);
+
+    /**
+     * @brief Parse a single report line
+     * @return true if the line is a valid report row
+     */
+    static bool parseLine(const std::string& line, ReportRecord& record);
+
+    /**
+     * @brief Number of malformed lines skipped so far
+     */
+    int getSkippedLines() const { return skippedLines; }
+
+    /**
+     * @brief Get the last error message
+     */
+    std::string getLastError() const { return lastError; }
+
+private:
+    std::ifstream in;
+    std::string line;
+    std::string lastError;
+    int skippedLines = 0;
+};
+
+#endif // REPORT_WRITER_H
@@ -27,6 +27,21 @@ public:
      */
     cv::Mat createResultImage(const cv::Mat& image,
                              const std::vector<Scratch>& scratches);
+
+    /**
+     * @brief Render the result image into a caller-owned canvas
+     *
+     * The canvas holds the image area and the info panel, so no separate
+     * panel or concatenation copy is made. Reusing the canvas across images
+     * of the same size avoids any reallocation.
+     * @param image Original image (8-bit, or 16-bit which is scaled to 8-bit)
+     * @param scratches Detected scratches (full-resolution coordinates)
+     * @param canvas Output image, (re)allocated only if its size changes
+     * @param scale Preview scale of the image area (at most 1.0)
+     */
+    void renderResult(const cv::Mat& image,
+                      const std::vector<Scratch>& scratches,
+                      cv::Mat& canvas, double scale = 1.0);
     
     /**
      * @brief Save result to file
@@ -39,9 +54,40 @@ public:
      * @brief Generate a text report
      * @param scratches Detected scratches
      * @param filepath Output file path
+     * @param cannyThreshold1 Lower Canny threshold used for the image
+     * @param cannyThreshold2 Upper Canny threshold used for the image
      */
     void generateReport(const std::vector<Scratch>& scratches,
-                       const std::string& filepath);
+                       const std::string& filepath,
+                       double cannyThreshold1, double cannyThreshold2);
+
+    /**
+     * @brief Pass/fail decision used by the reports
+     * @param scratches Detected scratches
+     * @return true if the part has at most maxScratchesForPass scratches
+     */
+    static bool isPassed(const std::vector<Scratch>& scratches) {
+        return scratches.size() <= maxScratchesForPass;
+    }
+
+    static constexpr size_t maxScratchesForPass = 5;
+
+private:
+    static constexpr int panelHeight = 150;
+
+    cv::Mat scaledGray;   // Reused resize buffer for grayscale previews
+    cv::Mat converted8u;  // Reused 8-bit copy of 16-bit inputs
+
+    /**
+     * @brief Draw scratch annotations, mapping coordinates by scale
+     */
+    void annotate(cv::Mat& target, const std::vector<Scratch>& scratches,
+                  double scale);
+
+    /**
+     * @brief Draw the info panel text
+     */
+    void drawPanel(cv::Mat& panel, const std::vector<Scratch>& scratches);
 };
 
 #endif // RESULT_VISUALIZER_H
\ No newline at end of file
@@ -1,14 +1,16 @@
 #ifndef SCRATCH_DETECTOR_H
 #define SCRATCH_DETECTOR_H
 
+#include "GaussianKernels.h"
 #include <opencv2/opencv.hpp>
+#include <memory>
 #include <vector>
 
 /**
  * @brief Structure to represent a detected scratch
  */
 struct Scratch {
-    std::vector<cv::Point> contour;  // The actual scratch shape
+    std::vector<cv::Point> contour;  // The actual scratch shape (segment end points for the line engine)
     cv::Rect boundingBox;             // Rectangle around the scratch
     cv::RotatedRect rotatedBox;       // Rotated Rectangle around the scratch
     double length;                    // Approximate length of scratch
@@ -18,6 +20,8 @@ struct Scratch {
     Scratch() : length(0), angle(0) {}
 };
 
+class DetectionEngine;
+
 /**
  * @brief Class that detects scratches in images
  */
@@ -27,6 +31,13 @@ public:
      * @brief Configure detection parameters
      */
     struct Parameters {
+        // Engine that turns the edge image into scratches
+        enum class Engine {
+            Contour,                  // External contours + geometric filter
+            LineSegment               // Hough line segments, merged per scratch
+        };
+        Engine engine;
+
         // Preprocessing
         int blurKernelSize;           // Size of Gaussian blur kernel (must be odd)
         
@@ -34,24 +45,42 @@ public:
         double cannyThreshold1;      // Lower threshold for Canny
         double cannyThreshold2;     // Upper threshold for Canny
         
+        // Automatic Canny thresholds (replace the fixed ones when enabled)
+        bool autoCanny;              // Derive thresholds per image from gradients
+        double maxEdgeDensity;      // Fraction of pixels allowed above the upper threshold
+        double cannyLowRatio;       // Lower threshold = ratio * upper threshold
+        double minAutoThreshold;    // Lower bound for the automatic upper threshold
+        
         // Scratch filtering
         double minLength;          // Minimum length to be considered a scratch
         double maxWidth;           // Maximum width (scratches are thin)
         double minAspectRatio;      // Length/width ratio (scratches are elongated)
 
+        // Line segment engine
+        int houghThreshold;        // Minimum Hough votes for a segment
+        double maxLineGap;         // Maximum gap bridged within one segment
+
         Parameters()
-            : blurKernelSize(5),
+            : engine(Engine::Contour),
+              blurKernelSize(5),
               cannyThreshold1(50),
               cannyThreshold2(150),
+              autoCanny(false),
+              maxEdgeDensity(0.05),
+              cannyLowRatio(0.4),
+              minAutoThreshold(30.0),
               minLength(20.0),
               maxWidth(10.0),
-              minAspectRatio(3.0) {} 
+              minAspectRatio(3.0),
+              houghThreshold(20),
+              maxLineGap(5.0) {}
     };
     
     /**
      * @brief Constructor with parameters
      */
     ScratchDetector(const Parameters& params = Parameters());
+    ~ScratchDetector();
     
     /**
      * @brief Detect scratches in an image
@@ -66,10 +95,25 @@ public:
     cv::Mat getProcessedImage() const { return processedImage; }
     cv::Mat getEdgeImage() const { return edgeImage; }
     
+    /**
+     * @brief Name of the active detection engine
+     */
+    const char* getEngineName() const;
+    
+    /**
+     * @brief Canny thresholds used for the last image (fixed or automatic)
+     */
+    double getUsedCannyThreshold1() const { return usedCannyThreshold1; }
+    double getUsedCannyThreshold2() const { return usedCannyThreshold2; }
+    
 private:
     Parameters params;
+    std::unique_ptr<DetectionEngine> engine;
+    GaussianBlurFunction fastBlur;  // Specialized blur, nullptr if none
     cv::Mat processedImage;  // Image after preprocessing
     cv::Mat edgeImage;        // Image after edge detection
+    double usedCannyThreshold1;
+    double usedCannyThreshold2;
     
     /**
      * @brief Preprocess the image (convert to grayscale, denoise)
@@ -82,9 +126,13 @@ private:
     cv::Mat detectEdges(const cv::Mat& image);
     
     /**
-     * @brief Analyze contour to determine if it's a scratch
+     * @brief Derive Canny thresholds from a subsampled gradient histogram
+     *
+     * The upper threshold is the gradient magnitude exceeded by only
+     * maxEdgeDensity of the pixels, which bounds the number of edge seeds
+     * (and so the contour analysis cost) on noisy or textured images.
      */
-    bool isScratch(const std::vector<cv::Point>& contour, Scratch& scratch);
+    void computeAutoThresholds(const cv::Mat& image, double& low, double& high) const;
 };
 
 #endif // SCRATCH_DETECTOR_H
\ No newline at end of file
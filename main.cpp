@@ -1,11 +1,22 @@
 #include "ImageLoader.h"
 #include "ScratchDetector.h"
 #include "ResultVisualizer.h"
+#include "ReportWriter.h"
+#include "DetectionEngine.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <filesystem>
 
-void processImage(const std::string& imagePath);
-void processBatch(const std::string& directory);
+void printUsage(const char* program);
+void processImage(const std::string& imagePath, bool autoCanny);
+void processBatch(const std::string& directory, bool autoCanny,
+                  const ImageLoader::ScanOptions& scanOptions);
+void readReport(const std::string& filepath);
+void benchmarkEngines(const std::string& directory);
+void benchmarkBlur(const std::string& imagePath);
+cv::Mat makeTestImage(std::vector<std::pair<cv::Point, cv::Point>>* lines);
 void createTestImage();
 void practiceMorphology();
 void practiceEdgeDetection();
@@ -17,9 +28,7 @@ int main(int argc, char** argv) {
     std::cout << "========================================\n\n";
     
     if (argc < 2) {
-        std::cout << "Usage for Scratch Detection:\n";
-        std::cout << "  Single image: " << argv[0] << " <image_path>\n";
-        std::cout << "  Batch mode:   " << argv[0] << " --batch <directory>\n";
+        printUsage(argv[0]);
         std::cout << "Now for practice OpenCV:\n";
         //practiceMorphology();
         //practiceEdgeDetection();
@@ -27,17 +36,81 @@ int main(int argc, char** argv) {
         return 1;
     }
     
-    std::string arg1 = argv[1];
-    if (arg1 == "--batch" && argc == 3) {
-        processBatch(argv[2]);
+    // Leading options
+    bool autoCanny = false;
+    ImageLoader::ScanOptions scanOptions;
+    bool includeGiven = false;
+    int argi = 1;
+    while (argi < argc) {
+        std::string option = argv[argi];
+        if (option == "--auto-canny") {
+            autoCanny = true;
+            argi++;
+        }
+        else if (option == "--recursive") {
+            scanOptions.recursive = true;
+            argi++;
+        }
+        else if ((option == "--include" || option == "--exclude") && argi + 1 >= argc) {
+            // Option without its value
+            printUsage(argv[0]);
+            return 1;
+        }
+        else if (option == "--include") {
+            // The first --include replaces the default image globs
+            if (!includeGiven) {
+                scanOptions.include.clear();
+                includeGiven = true;
+            }
+            scanOptions.include.push_back(argv[argi + 1]);
+            argi += 2;
+        }
+        else if (option == "--exclude") {
+            scanOptions.exclude.push_back(argv[argi + 1]);
+            argi += 2;
+        }
+        else {
+            break;
+        }
+    }
+    if (argi >= argc) {
+        // Options alone, nothing to process
+        printUsage(argv[0]);
+        return 1;
+    }
+    int remaining = argc - argi;
+    
+    std::string arg1 = argv[argi];
+    if (arg1 == "--batch" && remaining == 2) {
+        processBatch(argv[argi + 1], autoCanny, scanOptions);
     } 
+    else if (arg1 == "--read-report" && remaining == 2) {
+        readReport(argv[argi + 1]);
+    }
+    else if (arg1 == "--bench-engines" && remaining == 2) {
+        benchmarkEngines(argv[argi + 1]);
+    }
+    else if (arg1 == "--bench-blur" && remaining == 2) {
+        benchmarkBlur(argv[argi + 1]);
+    }
     else {
-        processImage(arg1);
+        processImage(arg1, autoCanny);
     }
     return 0;
 }
 
-void processImage(const std::string& imagePath) {
+void printUsage(const char* program) {
+    std::cout << "Usage for Scratch Detection:\n";
+    std::cout << "  Single image: " << program << " <image_path>\n";
+    std::cout << "  Batch mode:   " << program << " --batch <directory>\n";
+    std::cout << "  Options:      --auto-canny (per-image Canny thresholds)\n";
+    std::cout << "                --recursive, --include <glob>, --exclude <glob> (batch mode)\n";
+    std::cout << "  Read report:  " << program << " --read-report <report.jsonl>\n";
+    std::cout << "  Benchmark:    " << program << " --bench-engines <directory>\n";
+    std::cout << "                " << program << " --bench-blur <image_path>\n";
+}
+
+void processImage(const std::string& imagePath, bool autoCanny) {
     std::cout << "Processing: " << imagePath << "\n\n";
     
     // 1. Load image
@@ -66,6 +139,7 @@ void processImage(const std::string& imagePath) {
     // Tune these parameters!
     params.cannyThreshold1 = 50;
     params.cannyThreshold2 = 150;
+    params.autoCanny = autoCanny;
     params.minLength = 20;
     params.maxWidth = 15;
     params.minAspectRatio = 5.0;
@@ -87,72 +161,385 @@ void processImage(const std::string& imagePath) {
     visualizer.saveResult(image, "output/original.jpg");
     visualizer.saveResult(detector.getEdgeImage(), "output/edges.jpg");
     visualizer.saveResult(result, "output/result.jpg");
-    visualizer.generateReport(scratches, "output/report.txt");
+    visualizer.generateReport(scratches, "output/report.txt",
+                              detector.getUsedCannyThreshold1(),
+                              detector.getUsedCannyThreshold2());
     std::cout << "\nPress any key to close windows..." << std::endl;
     cv::waitKey(0);
     cv::destroyAllWindows();
 }
 
-void processBatch(const std::string& directory) {
+void processBatch(const std::string& directory, bool autoCanny,
+                  const ImageLoader::ScanOptions& scanOptions) {
     std::cout << "Batch processing: " << directory << "\n\n";
     
+    // Images are loaded one at a time from the sorted manifest, so the
+    // batch size is not limited by memory
     ImageLoader loader;
-    std::vector<cv::Mat> images = loader.loadImagesFromDirectory(directory);
+    std::vector<std::string> imagePaths = loader.scanDirectory(directory, scanOptions);
 
-    if (images.empty()) {
+    if (imagePaths.empty()) {
         std::cerr << "No images found in directory" << std::endl;
         return;
     }
+    std::cout << "Found " << imagePaths.size() << " images" << std::endl;
     
     ScratchDetector::Parameters params;
+    params.autoCanny = autoCanny;
     ScratchDetector detector(params);
     ResultVisualizer visualizer;
 
     std::filesystem::create_directories("output/batch");
 
+    // Result images are numbered by manifest position, so results of an
+    // earlier batch would be mistaken for this one's
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it("output/batch", ec), end;
+         !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.compare(0, 7, "result_") == 0 && it->path().extension() == ".jpg") {
+            std::error_code removeEc;
+            if (!std::filesystem::remove(it->path(), removeEc) && removeEc) {
+                std::cerr << "Warning: Failed to remove " << it->path().string()
+                          << ": " << removeEc.message() << std::endl;
+            }
+        }
+    }
+    if (ec) {
+        std::cerr << "Warning: Failed to list old results: " << ec.message() << std::endl;
+    }
+
+    std::ofstream manifest("output/batch/manifest.txt");
+    for (const auto& path : imagePaths) {
+        manifest << path << "\n";
+    }
+    manifest.close();
+
+    // One machine-readable report for the whole batch
+    ReportWriter reportWriter;
+    bool reportOpen = reportWriter.open("output/batch/report.jsonl");
+    if (!reportOpen) {
+        std::cerr << "Error: " << reportWriter.getLastError() << std::endl;
+    }
+    bool reportWritten = reportOpen;
+
+    const int previewWidth = 640;
+    cv::Mat preview;  // Reused for every result thumbnail
+
+    Prefetcher prefetcher(imagePaths);
+    size_t imageCount = 0;
     int totalScratches = 0;
-    for (size_t i = 0; i < images.size(); ++i) {
-        std::cout << "\nProcessing image " << (i+1) << "/" << images.size() << std::endl;
+    for (size_t i = 0; i < imagePaths.size(); ++i) {
+        std::cout << "\nProcessing image " << (i+1) << "/" << imagePaths.size() << std::endl;
         
-        std::vector<Scratch> scratches = detector.detect(images[i]);
+        prefetcher.advance(i);
+        cv::Mat image = loader.loadImage(imagePaths[i]);
+        if (image.empty() || !loader.isValidImage(image)) {
+            std::cerr << "Skipping invalid image: " << imagePaths[i] << std::endl;
+            if (reportWritten) {
+                reportWritten = reportWriter.writeImageError(
+                    imagePaths[i], image.empty() ? "unreadable image" : "invalid image");
+            }
+            continue;
+        }
+        imageCount++;
+        
+        std::vector<Scratch> scratches = detector.detect(image);
         totalScratches += scratches.size();
+        if (reportWritten) {
+            reportWritten = reportWriter.writeImage(imagePaths[i], scratches,
+                                                    detector.getUsedCannyThreshold1(),
+                                                    detector.getUsedCannyThreshold2());
+        }
         
-        cv::Mat result = visualizer.createResultImage(images[i], scratches);
+        // Only failed parts get a result image, rendered as an HMI thumbnail
+        if (ResultVisualizer::isPassed(scratches)) {
+            continue;
+        }
+        double scale = std::min(1.0, static_cast<double>(previewWidth) / image.cols);
+        visualizer.renderResult(image, scratches, preview, scale);
         
         std::string outputPath = "output/batch/result_" + std::to_string(i) + ".jpg";
-        visualizer.saveResult(result, outputPath);
+        visualizer.saveResult(preview, outputPath);
+    }
+    if (reportOpen) {
+        // close() is still needed after a failed write, to release the file
+        reportWritten = reportWriter.close() && reportWritten;
+        if (!reportWritten) {
+            std::cerr << "Error: " << reportWriter.getLastError() << std::endl;
+        }
     }
     
     std::cout << "\n=== Batch Processing Complete ===\n";
-    std::cout << "Images processed: " << images.size() << "\n";
+    std::cout << "Images processed: " << imageCount << "\n";
     std::cout << "Total scratches: " << totalScratches << "\n";
-    std::cout << "Average per image: " << (totalScratches / images.size()) << "\n";
+    if (imageCount > 0) {
+        std::cout << "Average per image: " << (totalScratches / imageCount) << "\n";
+    }
+    if (reportWritten) {
+        std::cout << "Report saved to: output/batch/report.jsonl\n";
+    }
+    std::cout << "Manifest saved to: output/batch/manifest.txt\n";
 }
 
-void createTestImage() {
+// Distance from p to the segment a-b
+static double distanceToSegment(cv::Point2f p, cv::Point2f a, cv::Point2f b) {
+    cv::Point2f ab = b - a, ap = p - a;
+    double t = (ap.x * ab.x + ap.y * ab.y) / (ab.x * ab.x + ab.y * ab.y);
+    t = std::max(0.0, std::min(1.0, t));
+    return cv::norm(ap - ab * t);
+}
+
+// Fraction of scratches in 'found' whose center lies in a scratch of 'reference'
+static double agreement(const std::vector<Scratch>& found,
+                        const std::vector<Scratch>& reference, int margin) {
+    if (found.empty()) return reference.empty() ? 1.0 : 0.0;
+    int matched = 0;
+    for (const auto& f : found) {
+        for (const auto& r : reference) {
+            cv::Rect box(r.boundingBox.x - margin, r.boundingBox.y - margin,
+                         r.boundingBox.width + 2 * margin, r.boundingBox.height + 2 * margin);
+            if (box.contains(f.centerPoint)) {
+                matched++;
+                break;
+            }
+        }
+    }
+    return static_cast<double>(matched) / found.size();
+}
+
+void benchmarkEngines(const std::string& directory) {
+    std::cout << "Engine benchmark: " << directory << "\n\n";
+
+    // Sample sets are <directory>/<name>/original.jpg
+    std::vector<std::string> samplePaths;
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it(directory, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec) && it->path().stem() == "original") {
+            samplePaths.push_back(it->path().string());
+        }
+    }
+    if (ec) {
+        std::cerr << "Error: Failed to scan " << directory << ": " << ec.message() << std::endl;
+        return;
+    }
+    std::sort(samplePaths.begin(), samplePaths.end());
+
+    // Same recipe as processImage, which produced the sample reports
+    ScratchDetector::Parameters params;
+    params.cannyThreshold1 = 50;
+    params.cannyThreshold2 = 150;
+    params.minLength = 20;
+    params.maxWidth = 15;
+    params.minAspectRatio = 5.0;
+
+    // Preprocessing and edge detection are shared by both engines, so the
+    // edge image is built once and only the engine stage is timed
+    ScratchDetector detector(params);
+    auto contourEngine = DetectionEngine::create(ScratchDetector::Parameters::Engine::Contour);
+    auto lineEngine = DetectionEngine::create(ScratchDetector::Parameters::Engine::LineSegment);
+
+    auto buildEdges = [&](const cv::Mat& image) {
+        detector.detect(image);
+        return detector.getEdgeImage().clone();
+    };
+
+    const int iterations = 5;
+    auto timeDetect = [&](DetectionEngine& engine, const cv::Mat& edges,
+                          std::vector<Scratch>& scratches) {
+        // The engines log their candidate counts; keep that out of the timing
+        std::streambuf* coutBuf = std::cout.rdbuf(nullptr);
+        cv::TickMeter tm;
+        for (int i = 0; i < iterations; ++i) {
+            tm.start();
+            scratches = engine.detect(edges, params);
+            tm.stop();
+        }
+        std::cout.rdbuf(coutBuf);
+        std::cout.clear();
+        return tm.getTimeMilli() / iterations;
+    };
+
+    struct Row { std::string name; double contourMs, lineMs; size_t contourCount, lineCount; double agree; };
+    std::vector<Row> rows;
+
+    ImageLoader loader;
+    for (const auto& path : samplePaths) {
+        cv::Mat image = loader.loadImage(path);
+        if (image.empty()) continue;
+        cv::Mat edges = buildEdges(image);
+
+        std::vector<Scratch> byContour, byLine;
+        Row row;
+        row.name = std::filesystem::path(path).parent_path().filename().string();
+        row.contourMs = timeDetect(*contourEngine, edges, byContour);
+        row.lineMs = timeDetect(*lineEngine, edges, byLine);
+        row.contourCount = byContour.size();
+        row.lineCount = byLine.size();
+        row.agree = agreement(byLine, byContour, static_cast<int>(params.maxWidth));
+        rows.push_back(row);
+    }
+
+    // Synthetic image with known scratches: recall of each engine
+    std::vector<std::pair<cv::Point, cv::Point>> truth;
+    cv::Mat testImage = makeTestImage(&truth);
+    auto recall = [&](const std::vector<Scratch>& scratches) {
+        int found = 0;
+        for (const auto& t : truth) {
+            double truthLength = cv::norm(cv::Point2f(t.second - t.first));
+            for (const auto& s : scratches) {
+                if (distanceToSegment(s.centerPoint, t.first, t.second) < params.maxWidth &&
+                    s.length >= 0.5 * truthLength) {
+                    found++;
+                    break;
+                }
+            }
+        }
+        return static_cast<double>(found) / truth.size();
+    };
+    cv::Mat testEdges = buildEdges(testImage);
+    std::vector<Scratch> synthContour, synthLine;
+    double synthContourMs = timeDetect(*contourEngine, testEdges, synthContour);
+    double synthLineMs = timeDetect(*lineEngine, testEdges, synthLine);
+
+    std::cout << "\n=== Engine Benchmark (" << iterations << " runs per image, engine stage only) ===\n";
+    std::cout << std::setw(12) << "Sample"
+              << std::setw(14) << "contour ms" << std::setw(10) << "count"
+              << std::setw(14) << "lines ms" << std::setw(10) << "count"
+              << std::setw(12) << "agree" << "\n";
+    std::cout << std::string(72, '-') << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& r : rows) {
+        std::cout << std::setw(12) << r.name
+                  << std::setw(14) << r.contourMs << std::setw(10) << r.contourCount
+                  << std::setw(14) << r.lineMs << std::setw(10) << r.lineCount
+                  << std::setw(11) << r.agree * 100 << "%\n";
+    }
+    std::cout << "\n'agree': share of line-engine scratches that overlap a contour-engine scratch\n";
+    std::cout << "\nSynthetic image (" << truth.size() << " known scratches):\n";
+    std::cout << "  contour: " << synthContourMs << " ms, " << synthContour.size()
+              << " detections, recall " << recall(synthContour) * 100 << "%\n";
+    std::cout << "  lines:   " << synthLineMs << " ms, " << synthLine.size()
+              << " detections, recall " << recall(synthLine) * 100 << "%\n";
+}
+
+void benchmarkBlur(const std::string& imagePath) {
+    std::cout << "Blur benchmark: " << imagePath << "\n\n";
+
+    cv::Mat gray = cv::imread(imagePath, cv::IMREAD_GRAYSCALE);
+    if (gray.empty()) {
+        std::cerr << "Error: Failed to load image: " << imagePath << std::endl;
+        return;
+    }
+
+    const int iterations = 50;
+    std::cout << "Image size: " << gray.cols << "x" << gray.rows
+              << ", " << iterations << " runs per kernel\n\n";
+    std::cout << std::setw(8) << "Kernel"
+              << std::setw(16) << "OpenCV ms" << std::setw(16) << "Specialized ms"
+              << std::setw(10) << "Speedup" << std::setw(10) << "MaxDiff" << "\n";
+    std::cout << std::string(60, '-') << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    // All specializations are measured, including those that
+    // selectGaussianBlur does not use
+    const std::pair<int, GaussianBlurFunction> kernels[] = {
+        {3, &gaussianBlur8u<3>}, {5, &gaussianBlur8u<5>}, {7, &gaussianBlur8u<7>}};
+
+    for (const auto& kernel : kernels) {
+        int k = kernel.first;
+        cv::Mat reference, fast;
+        cv::TickMeter generic, specialized;
+        for (int i = 0; i < iterations; ++i) {
+            generic.start();
+            cv::GaussianBlur(gray, reference, cv::Size(k, k), 0);
+            generic.stop();
+
+            specialized.start();
+            kernel.second(gray, fast);
+            specialized.stop();
+        }
+        double genericMs = generic.getTimeMilli() / iterations;
+        double specializedMs = specialized.getTimeMilli() / iterations;
+        std::cout << std::setw(8) << k
+                  << std::setw(16) << genericMs << std::setw(16) << specializedMs
+                  << std::setw(9) << genericMs / specializedMs << "x"
+                  << std::setw(10) << cv::norm(reference, fast, cv::NORM_INF)
+                  << (selectGaussianBlur(k) ? "" : "  (not used)") << "\n";
+    }
+}
+
+void readReport(const std::string& filepath) {
+    std::cout << "Reading report: " << filepath << "\n\n";
+
+    ReportReader reader;
+    if (!reader.open(filepath)) {
+        std::cerr << "Error: " << reader.getLastError() << std::endl;
+        return;
+    }
+
+    ReportRecord record;
+    while (reader.next(record)) {
+        switch (record.type) {
+            case ReportRecord::Type::Image:
+                if (!record.error.empty()) {
+                    std::cout << record.imageId << ": ERROR (" << record.error << ")\n";
+                    break;
+                }
+                std::cout << record.imageId << ": " << record.scratchCount
+                          << " scratches, max length " << record.maxLength
+                          << ", Canny " << record.cannyThreshold1 << "/" << record.cannyThreshold2
+                          << (record.passed ? " (PASSED)" : " (FAILED)") << "\n";
+                break;
+            case ReportRecord::Type::Batch:
+                std::cout << "\n=== Batch Summary ===\n";
+                std::cout << "Images: " << record.imageCount << "\n";
+                std::cout << "Total scratches: " << record.totalScratches << "\n";
+                std::cout << "Failed images: " << record.failedImages << "\n";
+                std::cout << "Unreadable images: " << record.errorImages << "\n";
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (reader.getSkippedLines() > 0) {
+        std::cerr << "Skipped " << reader.getSkippedLines() << " malformed lines" << std::endl;
+    }
+}
+
+cv::Mat makeTestImage(std::vector<std::pair<cv::Point, cv::Point>>* lines) {
     cv::Mat img = cv::Mat::zeros(500, 700, CV_8UC3);
     img.setTo(cv::Scalar(220, 220, 220)); // Gray background
     
-    // Draw a scratch (thin dark line)
-    cv::line(img, cv::Point(100, 100), cv::Point(400, 150), 
-             cv::Scalar(50, 50, 50), 2);
-    cv::line(img, cv::Point(200, 450), cv::Point(340, 300), 
-             cv::Scalar(50, 250, 50), 3);
-    cv::line(img, cv::Point(50, 150), cv::Point(100, 250), 
-             cv::Scalar(50, 50, 250), 6);
-    cv::line(img, cv::Point(450, 350), cv::Point(300, 450), 
-             cv::Scalar(50, 50, 0), 7);
-    cv::line(img, cv::Point(100, 150), cv::Point(400, 250), 
-             cv::Scalar(150, 50, 250), 6);
-    cv::line(img, cv::Point(350, 50), cv::Point(600, 350), 
-             cv::Scalar(50, 50, 150), 10);
+    // Draw scratches (end points, color, thickness)
+    struct TestLine { cv::Point p1, p2; cv::Scalar color; int thickness; };
+    const TestLine testLines[] = {
+        {cv::Point(100, 100), cv::Point(400, 150), cv::Scalar(50, 50, 50), 2},
+        {cv::Point(200, 450), cv::Point(340, 300), cv::Scalar(50, 250, 50), 3},
+        {cv::Point(50, 150), cv::Point(100, 250), cv::Scalar(50, 50, 250), 6},
+        {cv::Point(450, 350), cv::Point(300, 450), cv::Scalar(50, 50, 0), 7},
+        {cv::Point(100, 150), cv::Point(400, 250), cv::Scalar(150, 50, 250), 6},
+        {cv::Point(350, 50), cv::Point(600, 350), cv::Scalar(50, 50, 150), 10},
+    };
+    for (const auto& l : testLines) {
+        cv::line(img, l.p1, l.p2, l.color, l.thickness);
+        if (lines) {
+            lines->push_back({l.p1, l.p2});
+        }
+    }
    
     // Add noise
     cv::Mat noise(img.size(), img.type());
     cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(10));
     img += noise;
     
-    cv::imwrite("test2.png", img);
+    return img;
+}
+
+void createTestImage() {
+    cv::imwrite("test2.png", makeTestImage(nullptr));
 }
 
 void practiceMorphology() {
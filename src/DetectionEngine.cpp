@@ -0,0 +1,108 @@
+#include "DetectionEngine.h"
+#include <iostream>
+#include <cmath>
+
+std::unique_ptr<DetectionEngine> DetectionEngine::create(ScratchDetector::Parameters::Engine engine) {
+    switch (engine) {
+        case ScratchDetector::Parameters::Engine::LineSegment:
+            return std::make_unique<LineSegmentEngine>();
+        case ScratchDetector::Parameters::Engine::Contour:
+        default:
+            return std::make_unique<ContourEngine>();
+    }
+}
+
+std::vector<Scratch> ContourEngine::detect(const cv::Mat& edges,
+                                           const ScratchDetector::Parameters& params) {
+    std::vector<Scratch> scratches;
+    
+    // Find contours in the edge image
+    // HINTS:
+    // - Use cv::findContours()
+    // - Mode: cv::RETR_EXTERNAL (only external contours)
+    // - Method: cv::CHAIN_APPROX_SIMPLE (compress contours)
+    
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(edges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    
+    std::cout << "Found " << contours.size() << " contours" << std::endl;
+    
+    // Analyze each contour
+    // For each contour:
+    // 1. Create a Scratch object
+    // 2. Call isScratch() to check if it's actually a scratch
+    // 3. If it is, add it to the scratches vector
+    
+    for (const auto& contour : contours) {
+        Scratch scratch;
+        if (isScratch(contour, params, scratch)) {
+            scratches.push_back(scratch);
+        }
+    }
+    
+    return scratches;
+}
+
+bool ContourEngine::isScratch(const std::vector<cv::Point>& contour,
+                              const ScratchDetector::Parameters& params,
+                              Scratch& scratch) {
+    // TODO 3.6: Calculate contour properties
+    
+    // Step 1: Get bounding rectangle
+    // YOUR CODE HERE (1 line)
+    cv::Rect bbox = cv::boundingRect(contour);
+    cv::RotatedRect rbox = cv::minAreaRect(contour);
+    
+    
+    // Step 2: Calculate dimensions
+    cv::Point2f vertices[4];
+    rbox.points(vertices);
+    double width = cv::norm(vertices[0] - vertices[1]);
+    double height = cv::norm(vertices[1] - vertices[2]);
+    double thickness = std::min(width, height);
+    double length = std::max(width, height);
+    // double area = cv::contourArea(contour);
+    // double thickness = area/length;
+    
+    // TODO 3.7: Check if it matches scratch criteria
+    // A scratch is:
+    // - Long enough (length >= params.minLength)
+    // - Thin enough (thickness <= params.maxWidth)
+    // - Elongated (aspect ratio >= params.minAspectRatio)
+    
+    // YOUR CODE HERE (5-10 lines)
+    // Calculate aspect ratio
+    double aspectRatio = length / (thickness + 0.1); // +0.1 to avoid division by zero
+    
+    // Check all criteria
+    bool isValid = (length >= params.minLength) && (thickness <= params.maxWidth) 
+                    && (aspectRatio >= params.minAspectRatio);
+    //std::cout<< isValid <<":"<< length <<","<< thickness << ":" << aspectRatio <<std::endl;
+    if (!isValid) {
+        return false;
+    }
+    
+    // TODO 3.8: Fill in the Scratch structure
+    // Calculate:
+    // - contour (already provided)
+    // - boundingBox
+    // - rotatedBox
+    // - length
+    // - angle (use cv::minAreaRect and RotatedRect::angle)
+    // - centerPoint
+    
+    scratch.contour = contour;
+    scratch.boundingBox = bbox;
+
+    scratch.rotatedBox = rbox;
+    scratch.length = std::max(bbox.width, bbox.height);
+
+    // Get angle using minimum area rectangle
+    scratch.angle = rbox.angle;
+    
+    // Get center point
+    cv::Moments m = cv::moments(contour);
+    scratch.centerPoint = cv::Point2f(m.m10 / m.m00, m.m01 / m.m00);
+    
+    return isValid;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "GaussianKernels.h"
+
+GaussianBlurFunction selectGaussianBlur(int kernelSize) {
+    // Size 7 is left to cv::GaussianBlur: the specialization was only
+    // ~1.1x faster on the sample images and slower on the largest ones
+    // (see --bench-blur)
+    switch (kernelSize) {
+        case 3: return &gaussianBlur8u<3>;
+        case 5: return &gaussianBlur8u<5>;
+        default: return nullptr;
+    }
+}
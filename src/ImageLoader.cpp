@@ -1,7 +1,59 @@
 #include "ImageLoader.h"
+#include <algorithm>
+#include <cctype>
+#include <deque>
 #include <iostream>
 #include <filesystem>
 
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Case-insensitive glob match supporting '*' and '?'
+bool matchGlob(const std::string& pattern, const std::string& text) {
+    size_t p = 0, t = 0;
+    size_t star = std::string::npos, resume = 0;
+    while (t < text.size()) {
+        // '*' first, so a '*' in the text is not taken as its literal match
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = t;
+        }
+        else if (p < pattern.size() &&
+                 (pattern[p] == '?' ||
+                  std::tolower(static_cast<unsigned char>(pattern[p])) ==
+                  std::tolower(static_cast<unsigned char>(text[t])))) {
+            ++p;
+            ++t;
+        }
+        else if (star != std::string::npos) {
+            p = star + 1;
+            t = ++resume;
+        }
+        else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+bool matchesAny(const std::vector<std::string>& globs, const std::string& path) {
+    for (const auto& glob : globs) {
+        if (matchGlob(glob, path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
 cv::Mat ImageLoader::loadImage(const std::string& filepath) {
     // TODO 2.1: Implement image loading
     // HINTS:
@@ -30,22 +82,18 @@ std::vector<cv::Mat> ImageLoader::loadImagesFromDirectory(const std::string& dir
     
     // TODO 2.2: Load all images from directory
     // HINTS:
-    // - Use std::filesystem::directory_iterator (C++17)
-    // - Filter for image extensions (.jpg, .png, .bmp)
-    // - Use loadImage() for each file
+    // - Use scanDirectory() to list the image files (any case of
+    //   .jpg/.jpeg/.png/.bmp/.tif/.tiff)
+    // - Use loadImage() for each file, prefetching the next ones
     // - Only add images that loaded successfully
     
-    // YOUR CODE HERE (10-15 lines)
-    // Example structure:
-    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
-        if (entry.is_regular_file()) {
-            std::string ext = entry.path().extension().string();
-            if (ext == ".jpg" || ext == ".png" || ext == ".bmp") {
-                cv::Mat img = loadImage(entry.path().string());
-                if (!img.empty()) {
-                    images.push_back(img);
-                }
-            }
+    std::vector<std::string> manifest = scanDirectory(directory);
+    Prefetcher prefetcher(manifest);
+    for (size_t i = 0; i < manifest.size(); ++i) {
+        prefetcher.advance(i);
+        cv::Mat img = loadImage(manifest[i]);
+        if (!img.empty()) {
+            images.push_back(img);
         }
     }
     
@@ -54,6 +102,112 @@ std::vector<cv::Mat> ImageLoader::loadImagesFromDirectory(const std::string& dir
     return images;
 }
 
+std::vector<std::string> ImageLoader::scanDirectory(const std::string& directory,
+                                                    const ScanOptions& options) {
+    namespace fs = std::filesystem;
+    
+    const fs::path root(directory);
+    std::vector<std::string> manifest;
+    std::deque<fs::path> pending = {root};
+    int active = 0;          // Directories being listed right now
+    int failed = 0;          // Directories that could not be listed
+    std::mutex mutex;
+    std::condition_variable wake;
+    
+    // Each worker lists one directory at a time and queues its
+    // subdirectories; the scan ends when the queue is empty and idle
+    auto worker = [&]() {
+        std::vector<std::string> found;
+        std::vector<fs::path> subdirs;
+        while (true) {
+            fs::path dir;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return !pending.empty() || active == 0; });
+                if (pending.empty()) {
+                    break;
+                }
+                dir = std::move(pending.front());
+                pending.pop_front();
+                active++;
+            }
+            
+            subdirs.clear();
+            std::error_code ec;
+            fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec);
+            for (; !ec && it != fs::directory_iterator(); it.increment(ec)) {
+                const fs::directory_entry& entry = *it;
+                std::error_code typeEc;
+                std::string relative = entry.path().lexically_relative(root).generic_string();
+                bool excluded = matchesAny(options.exclude, relative) ||
+                                matchesAny(options.exclude, entry.path().filename().string());
+                if (entry.is_directory(typeEc)) {
+                    // Symlinked directories are not followed (no cycles)
+                    if (options.recursive && !entry.is_symlink(typeEc) && !excluded) {
+                        subdirs.push_back(entry.path());
+                    }
+                }
+                else if (entry.is_regular_file(typeEc)) {
+                    if ((options.include.empty() || matchesAny(options.include, relative)) &&
+                        !excluded) {
+                        found.push_back(entry.path().string());
+                    }
+                }
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ec) {
+                    failed++;
+                }
+                for (auto& subdir : subdirs) {
+                    pending.push_back(std::move(subdir));
+                }
+                active--;
+            }
+            wake.notify_all();
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        manifest.insert(manifest.end(), found.begin(), found.end());
+    };
+    
+    int threadCount = options.threads > 0
+        ? options.threads
+        : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    if (!options.recursive) {
+        threadCount = 1;
+    }
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    if (failed > 0) {
+        lastError = "Failed to read " + std::to_string(failed) + " directories under " + directory;
+        std::cerr << lastError << std::endl;
+    }
+    
+    std::sort(manifest.begin(), manifest.end());
+    return manifest;
+}
+
+void ImageLoader::prefetch(const std::string& filepath) {
+#if defined(__unix__) && defined(POSIX_FADV_WILLNEED)
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+#else
+    (void)filepath;
+#endif
+}
+
 bool ImageLoader::isValidImage(const cv::Mat& image) const {
     // TODO 2.3: Implement validation checks
     // Check if image:
@@ -69,4 +223,54 @@ bool ImageLoader::isValidImage(const cv::Mat& image) const {
     
     
     return true; // Replace with actual validation
-}
\ No newline at end of file
+}
+
+Prefetcher::Prefetcher(const std::vector<std::string>& files, size_t depth,
+                       int threads)
+    : files(files), depth(depth), current(0), next(1), stop(false) {
+    // next starts at 1: the consumer opens the first file right away
+    for (int i = 0; i < std::max(1, threads); ++i) {
+        workers.emplace_back(&Prefetcher::run, this);
+    }
+}
+
+Prefetcher::~Prefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void Prefetcher::advance(size_t index) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = index;
+    }
+    wake.notify_all();
+}
+
+void Prefetcher::run() {
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] {
+                return stop || next >= files.size() || next <= current + depth;
+            });
+            if (stop || next >= files.size()) {
+                return;
+            }
+            // Files the consumer already passed are not worth reading
+            index = std::max(next, current + 1);
+            next = index + 1;
+        }
+        // Outside the lock, so the other workers open files meanwhile
+        if (index < files.size()) {
+            ImageLoader::prefetch(files[index]);
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#include "DetectionEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+const double kMaxMergeAngle = 10.0;  // Degrees between merged segments
+
+// Groups are bucketed by axis angle, with buckets at least kMaxMergeAngle
+// wide, so a segment only has to be compared with the groups in its own
+// bucket and the two neighbouring ones
+const int kAngleBuckets = static_cast<int>(180.0 / kMaxMergeAngle);
+
+int angleBucket(double angle) {
+    int b = static_cast<int>(angle * kAngleBuckets / 180.0);
+    return std::min(b, kAngleBuckets - 1);
+}
+
+/**
+ * @brief Group of collinear segments that form one scratch
+ */
+struct SegmentGroup {
+    cv::Point2f origin;               // Point on the group's axis
+    cv::Point2f direction;            // Unit direction of the axis
+    double angle;                     // Axis angle in degrees, [0, 180)
+    double minProj, maxProj;          // Extent along the axis
+    std::vector<cv::Point> points;    // Segment end points
+};
+
+double segmentAngle(const cv::Vec4i& s) {
+    double a = std::atan2(s[3] - s[1], s[2] - s[0]) * 180.0 / CV_PI;
+    return a < 0 ? a + 180.0 : a;
+}
+
+double angleDifference(double a, double b) {
+    double d = std::fabs(a - b);
+    return std::min(d, 180.0 - d);
+}
+
+double project(const SegmentGroup& g, cv::Point2f p) {
+    return (p.x - g.origin.x) * g.direction.x + (p.y - g.origin.y) * g.direction.y;
+}
+
+double distanceToAxis(const SegmentGroup& g, cv::Point2f p) {
+    return std::fabs((p.x - g.origin.x) * g.direction.y - (p.y - g.origin.y) * g.direction.x);
+}
+
+} // namespace
+
+std::vector<Scratch> LineSegmentEngine::detect(const cv::Mat& edges,
+                                               const ScratchDetector::Parameters& params) {
+    std::vector<Scratch> scratches;
+
+    // Short segments are accepted here because pieces of one scratch are
+    // merged below; the length criterion is applied to the merged group
+    std::vector<cv::Vec4i> segments;
+    cv::HoughLinesP(edges, segments, 1, CV_PI / 180, params.houghThreshold,
+                    params.minLength / 2, params.maxLineGap);
+
+    std::cout << "Found " << segments.size() << " line segments" << std::endl;
+
+    // Longest segments first, so they define the group axes
+    std::sort(segments.begin(), segments.end(),
+              [](const cv::Vec4i& a, const cv::Vec4i& b) {
+                  return std::hypot(a[2] - a[0], a[3] - a[1]) >
+                         std::hypot(b[2] - b[0], b[3] - b[1]);
+              });
+
+    std::vector<SegmentGroup> groups;
+    std::vector<std::vector<size_t>> buckets(kAngleBuckets);  // Group indices per angle bucket
+    for (const auto& s : segments) {
+        cv::Point2f p1(s[0], s[1]), p2(s[2], s[3]);
+        double len = std::hypot(p2.x - p1.x, p2.y - p1.y);
+        // Zero-length segments (possible when minLength < 2) have no
+        // direction and would give a group a NaN axis
+        if (len < 1.0) continue;
+        double angle = segmentAngle(s);
+
+        // The earliest matching group wins, as in a scan over all groups
+        int bucket = angleBucket(angle);
+        size_t best = groups.size();
+        for (int d = -1; d <= 1; ++d) {
+            for (size_t index : buckets[(bucket + d + kAngleBuckets) % kAngleBuckets]) {
+                if (index >= best) break;
+                const SegmentGroup& g = groups[index];
+                if (angleDifference(angle, g.angle) > kMaxMergeAngle) continue;
+                if (distanceToAxis(g, p1) > params.maxWidth ||
+                    distanceToAxis(g, p2) > params.maxWidth) continue;
+                double a = project(g, p1), b = project(g, p2);
+                if (std::max(a, b) < g.minProj - params.maxLineGap ||
+                    std::min(a, b) > g.maxProj + params.maxLineGap) continue;
+                best = index;
+                break;
+            }
+        }
+
+        SegmentGroup* target = best < groups.size() ? &groups[best] : nullptr;
+
+        if (!target) {
+            SegmentGroup g;
+            g.origin = p1;
+            g.direction = cv::Point2f((p2.x - p1.x) / len, (p2.y - p1.y) / len);
+            g.angle = angle;
+            g.minProj = 0;
+            g.maxProj = len;
+            buckets[bucket].push_back(groups.size());
+            groups.push_back(g);
+            target = &groups.back();
+        }
+        else {
+            double a = project(*target, p1), b = project(*target, p2);
+            target->minProj = std::min(target->minProj, std::min(a, b));
+            target->maxProj = std::max(target->maxProj, std::max(a, b));
+        }
+        target->points.push_back(cv::Point(s[0], s[1]));
+        target->points.push_back(cv::Point(s[2], s[3]));
+    }
+
+    // Apply the same criteria as the contour engine to each group
+    for (const auto& g : groups) {
+        cv::RotatedRect rbox = cv::minAreaRect(g.points);
+        double length = std::max(rbox.size.width, rbox.size.height);
+        double thickness = std::min(rbox.size.width, rbox.size.height);
+        double aspectRatio = length / (thickness + 0.1);
+
+        if (length < params.minLength || thickness > params.maxWidth ||
+            aspectRatio < params.minAspectRatio) {
+            continue;
+        }
+
+        Scratch scratch;
+        scratch.contour = g.points;  // Segment end points, not a closed contour
+        scratch.boundingBox = cv::boundingRect(g.points);
+        scratch.rotatedBox = rbox;
+        scratch.length = length;
+        scratch.angle = rbox.angle;
+        scratch.centerPoint = rbox.center;
+        scratches.push_back(scratch);
+    }
+
+    return scratches;
+}
@@ -0,0 +1,358 @@
+#include "ReportWriter.h"
+#include "ResultVisualizer.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+// Append a JSON string literal, escaping quotes, backslashes and control chars
+void appendString(std::string& line, const std::string& value) {
+    line += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':  line += "\\\""; break;
+            case '\\': line += "\\\\"; break;
+            case '\n': line += "\\n"; break;
+            case '\r': line += "\\r"; break;
+            case '\t': line += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char esc[8];
+                    std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    line += esc;
+                }
+                else {
+                    line += c;
+                }
+        }
+    }
+    line += '"';
+}
+
+// Append a number with two decimals; NaN/inf (e.g. the center of a
+// zero-area contour) are written as null
+void appendNumber(std::string& line, double value) {
+    if (!std::isfinite(value)) {
+        line += "null";
+        return;
+    }
+    char num[32];
+    std::snprintf(num, sizeof(num), "%.2f", value);
+    line += num;
+}
+
+void appendField(std::string& line, const char* key, double value) {
+    line += ",\"";
+    line += key;
+    line += "\":";
+    appendNumber(line, value);
+}
+
+void appendField(std::string& line, const char* key, int value) {
+    line += ",\"";
+    line += key;
+    line += "\":";
+    line += std::to_string(value);
+}
+
+void skipSpaces(const std::string& s, size_t& pos) {
+    while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) {
+        ++pos;
+    }
+}
+
+bool parseString(const std::string& s, size_t& pos, std::string& value) {
+    if (pos >= s.size() || s[pos] != '"') return false;
+    ++pos;
+    value.clear();
+    while (pos < s.size() && s[pos] != '"') {
+        char c = s[pos++];
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+        if (pos >= s.size()) return false;
+        char e = s[pos++];
+        switch (e) {
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u':
+                if (pos + 4 > s.size()) return false;
+                value += static_cast<char>(std::strtol(s.substr(pos, 4).c_str(), nullptr, 16));
+                pos += 4;
+                break;
+            default:  value += e;
+        }
+    }
+    if (pos >= s.size()) return false;
+    ++pos;  // closing quote
+    return true;
+}
+
+// Convert a parsed number to int; null/true/false (NaN), fractions and
+// values outside the int range are rejected
+bool toInt(double num, int& value) {
+    if (!std::isfinite(num) || num != std::floor(num) ||
+        num < std::numeric_limits<int>::min() || num > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    value = static_cast<int>(num);
+    return true;
+}
+
+// Convert a parsed number to float; null stays NaN, finite values outside
+// the float range are rejected
+bool toFloat(double num, float& value) {
+    if (std::isfinite(num) && std::fabs(num) > std::numeric_limits<float>::max()) {
+        return false;
+    }
+    value = static_cast<float>(num);
+    return true;
+}
+
+// Store one key/value pair; returns false if the value is invalid for the key
+bool setField(ReportRecord& r, const std::string& key,
+              const std::string& text, double num) {
+    if (key == "type") {
+        if (text == "scratch")    r.type = ReportRecord::Type::Scratch;
+        else if (text == "image") r.type = ReportRecord::Type::Image;
+        else if (text == "batch") r.type = ReportRecord::Type::Batch;
+    }
+    else if (key == "image")      r.imageId = text;
+    else if (key == "id")         return toInt(num, r.scratchId);
+    else if (key == "cx")         return toFloat(num, r.scratch.centerPoint.x);
+    else if (key == "cy")         return toFloat(num, r.scratch.centerPoint.y);
+    else if (key == "length")     r.scratch.length = num;
+    else if (key == "angle")      r.scratch.angle = num;
+    else if (key == "rcx")        return toFloat(num, r.scratch.rotatedBox.center.x);
+    else if (key == "rcy")        return toFloat(num, r.scratch.rotatedBox.center.y);
+    else if (key == "rw")         return toFloat(num, r.scratch.rotatedBox.size.width);
+    else if (key == "rh")         return toFloat(num, r.scratch.rotatedBox.size.height);
+    else if (key == "rangle")     return toFloat(num, r.scratch.rotatedBox.angle);
+    else if (key == "bx")         return toInt(num, r.scratch.boundingBox.x);
+    else if (key == "by")         return toInt(num, r.scratch.boundingBox.y);
+    else if (key == "bw")         return toInt(num, r.scratch.boundingBox.width);
+    else if (key == "bh")         return toInt(num, r.scratch.boundingBox.height);
+    else if (key == "count")      return toInt(num, r.scratchCount);
+    else if (key == "passed")     r.passed = (text == "true");
+    else if (key == "max_length") r.maxLength = num;
+    else if (key == "canny_low")  r.cannyThreshold1 = num;
+    else if (key == "canny_high") r.cannyThreshold2 = num;
+    else if (key == "error")      r.error = text;
+    else if (key == "images")     return toInt(num, r.imageCount);
+    else if (key == "scratches")  return toInt(num, r.totalScratches);
+    else if (key == "failed")     return toInt(num, r.failedImages);
+    else if (key == "errors")     return toInt(num, r.errorImages);
+    // Unknown keys are ignored so that newer files stay readable
+    return true;
+}
+
+} // namespace
+
+ReportWriter::ReportWriter(size_t bufferSize)
+    : buffer(bufferSize), imageCount(0), totalScratches(0), failedImages(0), errorImages(0) {}
+
+ReportWriter::~ReportWriter() {
+    if (isOpen()) {
+        close();
+    }
+}
+
+bool ReportWriter::open(const std::string& filepath) {
+    if (isOpen()) {
+        close();
+    }
+    // The buffer must be installed before the file is opened
+    out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.open(filepath, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        lastError = "Failed to open report: " + filepath;
+        return false;
+    }
+    this->filepath = filepath;
+    imageCount = 0;
+    totalScratches = 0;
+    failedImages = 0;
+    errorImages = 0;
+    return true;
+}
+
+bool ReportWriter::writeLine(const std::string& line) {
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    if (out.fail()) {
+        lastError = "Failed to write report: " + filepath;
+        return false;
+    }
+    return true;
+}
+
+bool ReportWriter::writeImage(const std::string& imageId,
+                              const std::vector<Scratch>& scratches,
+                              double cannyThreshold1, double cannyThreshold2) {
+    if (!isOpen()) {
+        lastError = "Report is not open";
+        return false;
+    }
+
+    std::string line;
+    line.reserve(256);
+    double maxLength = 0;
+
+    for (size_t i = 0; i < scratches.size(); ++i) {
+        const auto& s = scratches[i];
+        maxLength = std::max(maxLength, s.length);
+
+        line = "{\"type\":\"scratch\",\"image\":";
+        appendString(line, imageId);
+        appendField(line, "id", static_cast<int>(i + 1));
+        appendField(line, "cx", s.centerPoint.x);
+        appendField(line, "cy", s.centerPoint.y);
+        appendField(line, "length", s.length);
+        appendField(line, "angle", s.angle);
+        appendField(line, "rcx", s.rotatedBox.center.x);
+        appendField(line, "rcy", s.rotatedBox.center.y);
+        appendField(line, "rw", s.rotatedBox.size.width);
+        appendField(line, "rh", s.rotatedBox.size.height);
+        appendField(line, "rangle", s.rotatedBox.angle);
+        appendField(line, "bx", s.boundingBox.x);
+        appendField(line, "by", s.boundingBox.y);
+        appendField(line, "bw", s.boundingBox.width);
+        appendField(line, "bh", s.boundingBox.height);
+        line += "}\n";
+        if (!writeLine(line)) return false;
+    }
+
+    bool passed = ResultVisualizer::isPassed(scratches);
+    line = "{\"type\":\"image\",\"image\":";
+    appendString(line, imageId);
+    appendField(line, "count", static_cast<int>(scratches.size()));
+    line += passed ? ",\"passed\":true" : ",\"passed\":false";
+    appendField(line, "max_length", maxLength);
+    appendField(line, "canny_low", cannyThreshold1);
+    appendField(line, "canny_high", cannyThreshold2);
+    line += "}\n";
+
+    imageCount++;
+    totalScratches += static_cast<int>(scratches.size());
+    if (!passed) {
+        failedImages++;
+    }
+    return writeLine(line);
+}
+
+bool ReportWriter::writeImageError(const std::string& imageId, const std::string& error) {
+    if (!isOpen()) {
+        lastError = "Report is not open";
+        return false;
+    }
+
+    // An image that was not inspected is never reported as passed
+    std::string line = "{\"type\":\"image\",\"image\":";
+    appendString(line, imageId);
+    appendField(line, "count", 0);
+    line += ",\"passed\":false,\"error\":";
+    appendString(line, error);
+    line += "}\n";
+
+    errorImages++;
+    return writeLine(line);
+}
+
+bool ReportWriter::close() {
+    if (!isOpen()) {
+        lastError = "Report is not open";
+        return false;
+    }
+    std::string line = "{\"type\":\"batch\"";
+    appendField(line, "images", imageCount);
+    appendField(line, "scratches", totalScratches);
+    appendField(line, "failed", failedImages);
+    appendField(line, "errors", errorImages);
+    line += "}\n";
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    // Buffered rows are only flushed here, so the state is checked after close
+    out.close();
+    if (out.fail()) {
+        lastError = "Failed to write report: " + filepath;
+        return false;
+    }
+    return true;
+}
+
+bool ReportReader::open(const std::string& filepath) {
+    in.open(filepath);
+    if (!in.is_open()) {
+        lastError = "Failed to open report: " + filepath;
+        return false;
+    }
+    skippedLines = 0;
+    return true;
+}
+
+bool ReportReader::next(ReportRecord& record) {
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (parseLine(line, record)) {
+            return true;
+        }
+        skippedLines++;
+        lastError = "Malformed report line: " + line;
+    }
+    return false;
+}
+
+bool ReportReader::parseLine(const std::string& line, ReportRecord& record) {
+    record = ReportRecord();
+    size_t pos = 0;
+    skipSpaces(line, pos);
+    if (pos >= line.size() || line[pos] != '{') return false;
+    ++pos;
+
+    std::string key, text;
+    while (true) {
+        skipSpaces(line, pos);
+        if (pos < line.size() && line[pos] == '}') break;
+        if (!parseString(line, pos, key)) return false;
+        skipSpaces(line, pos);
+        if (pos >= line.size() || line[pos] != ':') return false;
+        ++pos;
+        skipSpaces(line, pos);
+
+        double num = std::numeric_limits<double>::quiet_NaN();
+        if (pos < line.size() && line[pos] == '"') {
+            if (!parseString(line, pos, text)) return false;
+        }
+        else {
+            size_t end = line.find_first_of(",}", pos);
+            if (end == std::string::npos) return false;
+            text = line.substr(pos, end - pos);
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+                text.pop_back();
+            }
+            if (text != "null" && text != "true" && text != "false") {
+                char* parsed = nullptr;
+                num = std::strtod(text.c_str(), &parsed);
+                if (parsed == text.c_str() || *parsed != '\0') return false;
+            }
+            pos = end;
+        }
+        if (!setField(record, key, text, num)) return false;
+
+        skipSpaces(line, pos);
+        if (pos < line.size() && line[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (pos < line.size() && line[pos] == '}') break;
+        return false;
+    }
+    return record.type != ReportRecord::Type::Unknown;
+}
@@ -1,4 +1,5 @@
 #include "ResultVisualizer.h"
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 
@@ -12,6 +13,68 @@ cv::Mat ResultVisualizer::drawScratches(const cv::Mat& image,
         cv::cvtColor(result, result, cv::COLOR_GRAY2BGR);
     }
     
+    annotate(result, scratches, 1.0);
+    return result;
+}
+
+cv::Mat ResultVisualizer::createResultImage(const cv::Mat& image,
+                                           const std::vector<Scratch>& scratches) {
+    cv::Mat result;
+    renderResult(image, scratches, result, 1.0);
+    return result;
+}
+
+void ResultVisualizer::renderResult(const cv::Mat& image,
+                                    const std::vector<Scratch>& scratches,
+                                    cv::Mat& canvas, double scale) {
+    // The canvas is 8-bit BGR; any other input would make the ROI writes
+    // below reallocate instead of filling the canvas
+    cv::Mat source = image;
+    if (image.depth() == CV_16U) {
+        image.convertTo(converted8u, CV_8U, 1.0 / 256);
+        source = converted8u;
+    }
+    CV_Assert(source.depth() == CV_8U &&
+              (source.channels() == 1 || source.channels() == 3));
+
+    scale = std::min(scale, 1.0);
+    int width = std::max(1, cvRound(source.cols * scale));
+    int height = std::max(1, cvRound(source.rows * scale));
+
+    // No-op when the canvas already has this size, so a canvas kept across
+    // images of the same size is never reallocated
+    canvas.create(height + panelHeight, width, CV_8UC3);
+    cv::Mat imageArea = canvas(cv::Rect(0, 0, width, height));
+    cv::Mat panel = canvas(cv::Rect(0, height, width, panelHeight));
+
+    // Write the (scaled) input straight into the canvas; ROI outputs of the
+    // right size and type are filled in place
+    if (source.channels() == 1) {
+        if (scale < 1.0) {
+            cv::resize(source, scaledGray, imageArea.size(), 0, 0, cv::INTER_AREA);
+            cv::cvtColor(scaledGray, imageArea, cv::COLOR_GRAY2BGR);
+        }
+        else {
+            cv::cvtColor(source, imageArea, cv::COLOR_GRAY2BGR);
+        }
+    }
+    else if (scale < 1.0) {
+        cv::resize(source, imageArea, imageArea.size(), 0, 0, cv::INTER_AREA);
+    }
+    else {
+        source.copyTo(imageArea);
+    }
+
+    annotate(imageArea, scratches, scale);
+
+    // Blue (BGR) panel, as produced by the former Mat::ones(...) * 255
+    panel.setTo(cv::Scalar(255, 0, 0));
+    drawPanel(panel, scratches);
+}
+
+void ResultVisualizer::annotate(cv::Mat& target,
+                                const std::vector<Scratch>& scratches,
+                                double scale) {
     // TODO 4.1: Draw each scratch
     // For each scratch:
     // 1. Draw the contour in red
@@ -23,51 +86,41 @@ cv::Mat ResultVisualizer::drawScratches(const cv::Mat& image,
     
     for (const auto& scratch : scratches) {
         // Draw contour
-        std::vector<std::vector<cv::Point>> contours = {scratch.contour};
-        //cv::drawContours(result, contours, 0, cv::Scalar(0, 0, 255), 2);
+        //cv::drawContours(target, {scratch.contour}, 0, cv::Scalar(0, 0, 255), 2);
    
         // Draw bounding box
-        cv::rectangle(result, scratch.boundingBox, cv::Scalar(0, 255, 255), 2);
+        cv::Rect bbox(cvRound(scratch.boundingBox.x * scale),
+                      cvRound(scratch.boundingBox.y * scale),
+                      cvRound(scratch.boundingBox.width * scale),
+                      cvRound(scratch.boundingBox.height * scale));
+        cv::rectangle(target, bbox, cv::Scalar(0, 255, 255), 2);
 
         //Draw rotated box
         cv::Point2f vertices[4];
         scratch.rotatedBox.points(vertices);
         for(int j = 0; j< 4 ; ++j) {
-            cv::line(result, vertices[j], vertices[(j+1)%4], cv::Scalar(0, 120, 120), 2);
+            cv::line(target, vertices[j] * scale, vertices[(j+1)%4] * scale,
+                     cv::Scalar(0, 120, 120), 2);
         }
        
         // Draw center point
-        cv::circle(result, scratch.centerPoint, 3, cv::Scalar(0, 255, 0), -1);
+        cv::circle(target, scratch.centerPoint * scale, 3, cv::Scalar(0, 255, 0), -1);
         
         // Add label
         std::string label = "S" + std::to_string(scratchNum++);
-        cv::putText(result, label, 
-                    cv::Point(scratch.boundingBox.x, scratch.boundingBox.y - 5),
+        cv::putText(target, label, 
+                    cv::Point(bbox.x, bbox.y - 5),
                     cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255, 255, 255), 2);
     }
-    return result;
 }
 
-cv::Mat ResultVisualizer::createResultImage(const cv::Mat& image,
-                                           const std::vector<Scratch>& scratches) {
-    // Draw scratches on image
-    cv::Mat annotated = drawScratches(image, scratches);
-    
+void ResultVisualizer::drawPanel(cv::Mat& panel,
+                                 const std::vector<Scratch>& scratches) {
     // TODO 4.2: Create info panel
     // Create a panel showing:
     // - Number of scratches
     // - Status (PASS/FAIL based on threshold)
     // - Largest scratch info
-    
-    // Create a white panel
-    int panelHeight = 150;
-    cv::Mat panel = cv::Mat::ones(panelHeight, annotated.cols, CV_8UC3) * 255;
-    
-    // Example structure:
-    // - Calculate statistics (count, max length, etc.)
-    // - Draw text on panel using cv::putText()
-    // - Add colored status indicator
-    // 
     int yPos = 30;
     cv::putText(panel, "Defect Detection Results", 
                cv::Point(20, yPos), cv::FONT_HERSHEY_PLAIN, 1.0,
@@ -78,18 +131,6 @@ cv::Mat ResultVisualizer::createResultImage(const cv::Mat& image,
     cv::putText(panel, countText, cv::Point(20, yPos), 
                cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 0, 0), 2);
     // ... add more info
-    
-    
-    // TODO 4.3: Combine image and panel
-    // Use cv::vconcat() to stack them vertically
-    
-    cv::Mat result;
-    
-    // YOUR CODE HERE (2 lines)
-    cv::vconcat(annotated, panel, result);
-    
-    
-    return result;
 }
 
 bool ResultVisualizer::saveResult(const cv::Mat& image, 
@@ -111,7 +152,8 @@ bool ResultVisualizer::saveResult(const cv::Mat& image,
 }
 
 void ResultVisualizer::generateReport(const std::vector<Scratch>& scratches,
-                                     const std::string& filepath) {
+                                     const std::string& filepath,
+                                     double cannyThreshold1, double cannyThreshold2) {
     // TODO 4.5: Generate text report
     // Create a detailed text file with:
     // - Summary statistics
@@ -122,7 +164,8 @@ void ResultVisualizer::generateReport(const std::vector<Scratch>& scratches,
 
     report << "=== Scratch Detection Report ===\n\n";
     report << "Total Scratches: " << scratches.size() << "\n";
-    report << "Status: " << (scratches.size() > 5 ? "FAILED" : "PASSED") << "\n\n";
+    report << "Status: " << (isPassed(scratches) ? "PASSED" : "FAILED") << "\n";
+    report << "Canny Thresholds: " << cannyThreshold1 << ", " << cannyThreshold2 << "\n\n";
 
     report << "Detailed List:\n";
     report << std::setw(5) << "ID" 
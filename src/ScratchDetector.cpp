@@ -1,16 +1,36 @@
 #include "ScratchDetector.h"
+#include "DetectionEngine.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <cmath>
 
 ScratchDetector::ScratchDetector(const Parameters& params) 
-    : params(params) {
+    : params(params), engine(DetectionEngine::create(params.engine)),
+      fastBlur(selectGaussianBlur(params.blurKernelSize)),
+      usedCannyThreshold1(params.cannyThreshold1),
+      usedCannyThreshold2(params.cannyThreshold2) {
     std::cout << "Scratch Detector initialized with parameters:" << std::endl;
-    std::cout << "  - Blur kernel: " << params.blurKernelSize << std::endl;
-    std::cout << "  - Canny thresholds: " << params.cannyThreshold1 
-              << ", " << params.cannyThreshold2 << std::endl;
+    std::cout << "  - Engine: " << engine->name() << std::endl;
+    std::cout << "  - Blur kernel: " << params.blurKernelSize
+              << (fastBlur ? " (specialized)" : "") << std::endl;
+    if (params.autoCanny) {
+        std::cout << "  - Canny thresholds: auto (max edge density "
+                  << params.maxEdgeDensity << ")" << std::endl;
+    }
+    else {
+        std::cout << "  - Canny thresholds: " << params.cannyThreshold1 
+                  << ", " << params.cannyThreshold2 << std::endl;
+    }
     std::cout << "  - Min length: " << params.minLength << std::endl;
 }
 
+ScratchDetector::~ScratchDetector() = default;
+
+const char* ScratchDetector::getEngineName() const {
+    return engine->name();
+}
+
 std::vector<Scratch> ScratchDetector::detect(const cv::Mat& image) {
     std::vector<Scratch> scratches;
     
@@ -22,41 +42,16 @@ std::vector<Scratch> ScratchDetector::detect(const cv::Mat& image) {
     // Step 2: Edge detection
     edgeImage = detectEdges(processedImage);
     
-    // Find contours in the edge image
-    // HINTS:
-    // - Use cv::findContours()
-    // - Mode: cv::RETR_EXTERNAL (only external contours)
-    // - Method: cv::CHAIN_APPROX_SIMPLE (compress contours)
-    
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(edgeImage, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-    
-    std::cout << "Found " << contours.size() << " contours" << std::endl;
-    
-    // Analyze each contour
-    // For each contour:
-    // 1. Create a Scratch object
-    // 2. Call isScratch() to check if it's actually a scratch
-    // 3. If it is, add it to the scratches vector
-    
-    int scratchCount = 0;
-    
-
-    for (const auto& contour : contours) {
-        Scratch scratch;
-        if (isScratch(contour, scratch)) {
-            scratches.push_back(scratch);
-            scratchCount++;
-        }
-    }
+    // Step 3: Shape analysis
+    scratches = engine->detect(edgeImage, params);
     
-    std::cout << "Detected " << scratchCount << " scratches" << std::endl;
+    std::cout << "Detected " << scratches.size() << " scratches" << std::endl;
     
     return scratches;
 }
 
 cv::Mat ScratchDetector::preprocessImage(const cv::Mat& image) {
-    cv::Mat processed;
+    cv::Mat gray, processed;
     
     std::cout << "Preprocessing image..." << std::endl;
     
@@ -64,13 +59,13 @@ cv::Mat ScratchDetector::preprocessImage(const cv::Mat& image) {
     // HINTS:
     // - Check if image has 3 channels (color) with image.channels()
     // - Use cv::cvtColor() with cv::COLOR_BGR2GRAY
-    // - If already grayscale, just clone it
+    // - If already grayscale, use it directly (the blur writes a new image)
     
     if (image.channels() == 3) {
-        cv::cvtColor(image, processed, cv::COLOR_BGR2GRAY);
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
     } 
     else {
-        processed = image.clone();
+        gray = image;
     }
     
     
@@ -80,7 +75,15 @@ cv::Mat ScratchDetector::preprocessImage(const cv::Mat& image) {
     // - Kernel size: params.blurKernelSize (must be odd!)
     // - Sigma: 0 (auto-calculate based on kernel size)
     
-    cv::GaussianBlur(processed, processed, cv::Size(params.blurKernelSize, params.blurKernelSize), 0);
+    // Specialized integer kernels for 8-bit images; same result as
+    // cv::GaussianBlur with sigma 0
+    int k = params.blurKernelSize;
+    if (fastBlur && gray.type() == CV_8UC1 && gray.rows >= k && gray.cols >= k) {
+        fastBlur(gray, processed);
+    }
+    else {
+        cv::GaussianBlur(gray, processed, cv::Size(k, k), 0);
+    }
     
     std::cout << "  Converted to grayscale and blurred" << std::endl;
     
@@ -98,72 +101,53 @@ cv::Mat ScratchDetector::detectEdges(const cv::Mat& image) {
     // - Parameters: image, output, threshold1, threshold2
     // - Use params.cannyThreshold1 and params.cannyThreshold2
     
-    cv::Canny(image, edges, params.cannyThreshold1, params.cannyThreshold2);
+    usedCannyThreshold1 = params.cannyThreshold1;
+    usedCannyThreshold2 = params.cannyThreshold2;
+    if (params.autoCanny && image.type() == CV_8UC1) {
+        computeAutoThresholds(image, usedCannyThreshold1, usedCannyThreshold2);
+        std::cout << "  Auto thresholds: " << usedCannyThreshold1
+                  << ", " << usedCannyThreshold2 << std::endl;
+    }
+    
+    cv::Canny(image, edges, usedCannyThreshold1, usedCannyThreshold2);
     
     std::cout << "  Edge detection complete" << std::endl;
     
     return edges;
 }
 
-bool ScratchDetector::isScratch(const std::vector<cv::Point>& contour, 
-                                Scratch& scratch) {
-    // TODO 3.6: Calculate contour properties
-    
-    // Step 1: Get bounding rectangle
-    // YOUR CODE HERE (1 line)
-    cv::Rect bbox = cv::boundingRect(contour);
-    cv::RotatedRect rbox = cv::minAreaRect(contour);
-    
-    
-    // Step 2: Calculate dimensions
-    cv::Point2f vertices[4];
-    rbox.points(vertices);
-    double width = cv::norm(vertices[0] - vertices[1]);
-    double height = cv::norm(vertices[1] - vertices[2]);
-    double thickness = std::min(width, height);
-    double length = std::max(width, height);
-    // double area = cv::contourArea(contour);
-    // double thickness = area/length;
-    
-    // TODO 3.7: Check if it matches scratch criteria
-    // A scratch is:
-    // - Long enough (length >= params.minLength)
-    // - Thin enough (thickness <= params.maxWidth)
-    // - Elongated (aspect ratio >= params.minAspectRatio)
-    
-    // YOUR CODE HERE (5-10 lines)
-    // Calculate aspect ratio
-    double aspectRatio = length / (thickness + 0.1); // +0.1 to avoid division by zero
-    
-    // Check all criteria
-    bool isValid = (length >= params.minLength) && (thickness <= params.maxWidth) 
-                    && (aspectRatio >= params.minAspectRatio);
-    //std::cout<< isValid <<":"<< length <<","<< thickness << ":" << aspectRatio <<std::endl;
-    if (!isValid) {
-        return false;
+void ScratchDetector::computeAutoThresholds(const cv::Mat& image,
+                                            double& low, double& high) const {
+    // Histogram of |gx| + |gy| of the 3x3 Sobel, the magnitude cv::Canny
+    // compares against its thresholds, on every 4th pixel of every 4th row
+    const int step = 4;
+    const int maxMagnitude = 8 * 255;
+    std::vector<int> histogram(maxMagnitude + 1, 0);
+    int samples = 0;
+    
+    for (int y = 1; y < image.rows - 1; y += step) {
+        const uchar* above = image.ptr<uchar>(y - 1);
+        const uchar* row = image.ptr<uchar>(y);
+        const uchar* below = image.ptr<uchar>(y + 1);
+        for (int x = 1; x < image.cols - 1; x += step) {
+            int gx = (above[x + 1] + 2 * row[x + 1] + below[x + 1])
+                   - (above[x - 1] + 2 * row[x - 1] + below[x - 1]);
+            int gy = (below[x - 1] + 2 * below[x] + below[x + 1])
+                   - (above[x - 1] + 2 * above[x] + above[x + 1]);
+            histogram[std::abs(gx) + std::abs(gy)]++;
+            samples++;
+        }
     }
     
-    // TODO 3.8: Fill in the Scratch structure
-    // Calculate:
-    // - contour (already provided)
-    // - boundingBox
-    // - rotatedBox
-    // - length
-    // - angle (use cv::minAreaRect and RotatedRect::angle)
-    // - centerPoint
-    
-    scratch.contour = contour;
-    scratch.boundingBox = bbox;
-
-    scratch.rotatedBox = rbox;
-    scratch.length = std::max(bbox.width, bbox.height);
-
-    // Get angle using minimum area rectangle
-    scratch.angle = rbox.angle;
-    
-    // Get center point
-    cv::Moments m = cv::moments(contour);
-    scratch.centerPoint = cv::Point2f(m.m10 / m.m00, m.m01 / m.m00);
+    // Smallest magnitude with at most maxEdgeDensity of the samples above it
+    int limit = static_cast<int>(samples * params.maxEdgeDensity);
+    int count = 0;
+    int magnitude = maxMagnitude;
+    while (magnitude > 0 && count + histogram[magnitude] <= limit) {
+        count += histogram[magnitude];
+        magnitude--;
+    }
     
-    return isValid;
-}
\ No newline at end of file
+    high = std::max(static_cast<double>(magnitude), params.minAutoThreshold);
+    low = high * params.cannyLowRatio;
+}